@@ -0,0 +1,41 @@
+// Copyright © 2018 The Things Network Foundation, The Things Products B.V.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIB_GATEWAY_MODULE_INTERFACE_CONFIG_H_
+#define LIB_GATEWAY_MODULE_INTERFACE_CONFIG_H_
+
+// All static buffers of the library are sized by the defines below. Each of them can be overridden
+// from the compiler command line (e.g. -DGATEWAY_MODULE_DRAIN_SLOTS=2).
+
+// Size (bytes) of a RECEIVE message buffer, also the maximum accepted RECEIVE payload length
+#ifndef GATEWAY_MODULE_RECEIVE_BUFFER_SIZE
+#define GATEWAY_MODULE_RECEIVE_BUFFER_SIZE 300
+#endif
+
+// Number of packet slots (each GATEWAY_MODULE_RECEIVE_BUFFER_SIZE bytes) used while draining the RX queue
+#ifndef GATEWAY_MODULE_DRAIN_SLOTS
+#define GATEWAY_MODULE_DRAIN_SLOTS 4
+#endif
+
+// Upper limit of packets pulled in one drain
+#ifndef GATEWAY_MODULE_DRAIN_MAX_PACKETS
+#define GATEWAY_MODULE_DRAIN_MAX_PACKETS 64
+#endif
+
+// Timeout (ms) waiting for the module to send the next packet while draining
+#ifndef GATEWAY_MODULE_DRAIN_TIMEOUT
+#define GATEWAY_MODULE_DRAIN_TIMEOUT 100
+#endif
+
+#endif /* LIB_GATEWAY_MODULE_INTERFACE_CONFIG_H_ */
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <stddef.h>
+#include <string.h>
 #include "gateway-module-interface.h"
 
 #define LOG(...)                \
@@ -26,6 +27,19 @@
 #define FRAME_START 0x23
 #define FRAME_CR 0x0D
 
+#define FRAME_MAX_LENGTH 0xFFFF // Length is sent in two bytes (len0, len1)
+
+#define RECEIVE_BUFFER_SIZE GATEWAY_MODULE_RECEIVE_BUFFER_SIZE
+#define DRAIN_SLOTS GATEWAY_MODULE_DRAIN_SLOTS
+#define DRAIN_MAX_PACKETS GATEWAY_MODULE_DRAIN_MAX_PACKETS
+#define DRAIN_TIMEOUT GATEWAY_MODULE_DRAIN_TIMEOUT
+
+_Static_assert(RECEIVE_BUFFER_SIZE > 0, "RX buffer can not be empty");
+_Static_assert(RECEIVE_BUFFER_SIZE <= FRAME_MAX_LENGTH, "RX buffer larger than the maximum frame length");
+_Static_assert(DRAIN_SLOTS >= 0, "Drain slots can not be negative (0 disables the drain)");
+_Static_assert(DRAIN_MAX_PACKETS > 0, "Drain limit must be positive");
+_Static_assert(DRAIN_TIMEOUT > 0, "Drain timeout must be positive");
+
 typedef enum {
     STATE_WAIT_FOR_START,
     STATE_WAIT_FOR_CMD,
@@ -59,6 +73,13 @@ typedef struct
     uint8_t               sequence;
 } rx_context_t;
 
+typedef struct
+{
+    bool    active;
+    size_t  fill;     // Slots filled by the dispatcher
+    uint8_t received; // Incremented for every packet stored in a slot
+} drain_context_t;
+
 typedef struct
 {
     uint8_t start;
@@ -75,6 +96,10 @@ typedef struct
 
 static void setState(STATE_t newState);
 static size_t maxAnswerLength(GATEWAY_MODULE_CMDS_t cmd);
+#if DRAIN_SLOTS > 0
+static void flushDrainBatch(gateway_module_receive_batch_callback_t batch_callback,
+                            gateway_module_drain_stats_t*           stats);
+#endif
 
 static gateway_module_interface_write_lock_t g_write_lock;
 static gateway_module_interface_write_t      g_write;
@@ -86,7 +111,12 @@ static answer_context_t                      g_pending_command;
 static rx_context_t                          g_rx_context;
 static STATE_t                               g_state;
 static RX_TYPE_t                             g_rx_type;
-static uint8_t                               g_receive_buffer[300];
+static uint8_t                               g_receive_buffer[RECEIVE_BUFFER_SIZE];
+#if DRAIN_SLOTS > 0
+static drain_context_t                       g_drain;
+static uint8_t                               g_drain_buffer[DRAIN_SLOTS][RECEIVE_BUFFER_SIZE];
+static gateway_module_packet_t               g_drain_packets[DRAIN_SLOTS];
+#endif
 
 void GatewayModuleInterface_init(gateway_module_interface_write_lock_t write_lock,
                                  gateway_module_interface_write_t write, gateway_module_signal_wait_t signal_wait,
@@ -213,6 +243,115 @@ void GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMDS_t cmd, bool ack)
     g_write_lock(false);
 }
 
+#if DRAIN_SLOTS > 0
+bool GatewayModuleInterface_drainReceiveQueue(gateway_module_receive_batch_callback_t batch_callback,
+                                              gateway_module_get_time_t get_time, gateway_module_drain_stats_t* stats)
+{
+    bool     ret     = true;
+    bool     retry   = true;
+    uint8_t  pending = 0;
+    uint8_t  received;
+    uint32_t start = (get_time != NULL) ? get_time() : 0;
+
+    gateway_module_drain_stats_t local_stats;
+    if(stats == NULL)
+    {
+        stats = &local_stats;
+    }
+    stats->pending     = 0;
+    stats->packets     = 0;
+    stats->batches     = 0;
+    stats->truncated   = false;
+    stats->duration_ms = 0;
+
+    // from here on RECEIVE messages are stored in the drain slots and acked by the drain
+    g_drain.fill   = 0;
+    received       = g_drain.received;
+    g_drain.active = true;
+
+    ret            = GatewayModuleInterface_sendCommandWaitAnswer(GATEWAY_MODULE_CMD_RXSTATUS, NULL, 0, &pending, 1);
+    stats->pending = pending;
+
+    // trigger the module to send the first packet, the next ones are sent by the module after each ack
+    if(ret && pending > 0 && received == g_drain.received)
+    {
+        GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMD_RECEIVE, false);
+    }
+
+    while(ret && pending > 0 && stats->packets < DRAIN_MAX_PACKETS)
+    {
+        retry = true;
+        while(received == g_drain.received)
+        {
+            if(!g_signal_wait(DRAIN_TIMEOUT))
+            {
+                if(!retry)
+                {
+                    break;
+                }
+                // nothing received within the timeout, trigger the module to send the packet
+                GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMD_RECEIVE, false);
+                retry = false;
+            }
+        }
+        if(received == g_drain.received)
+        {
+            LOG("Drain timeout, pending: %d", pending);
+            ret = false;
+            break;
+        }
+        received++;
+        pending--;
+        stats->packets++;
+
+        // free the slots before the module is allowed to send the next packet
+        if(g_drain.fill >= DRAIN_SLOTS)
+        {
+            flushDrainBatch(batch_callback, stats);
+        }
+        GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMD_RECEIVE, true);
+
+        if(pending == 0)
+        {
+            // check for packets queued during the drain
+            ret = GatewayModuleInterface_sendCommandWaitAnswer(GATEWAY_MODULE_CMD_RXSTATUS, NULL, 0, &pending, 1);
+        }
+    }
+
+    // finish a frame in progress, so it is either handled by the drain or by the receive callback
+    while(g_state != STATE_WAIT_FOR_START)
+    {
+        if(!g_signal_wait(DRAIN_TIMEOUT))
+        {
+            break;
+        }
+    }
+    g_drain.active = false;
+
+    // packets completed after the last wait are handed over by the drain as well
+    while(received != g_drain.received)
+    {
+        received++;
+        stats->packets++;
+        GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMD_RECEIVE, true);
+    }
+    flushDrainBatch(batch_callback, stats);
+
+    // the packet limit is not an error, the remaining packets are passed to the receive callback as usual
+    stats->truncated = ret && (pending > 0);
+
+    if(get_time != NULL)
+    {
+        stats->duration_ms = get_time() - start;
+    }
+
+    LOG("Drain, pending: %d, packets: %d, batches: %d, truncated: %d, duration: %d ms", stats->pending,
+        stats->packets, stats->batches, stats->truncated, stats->duration_ms);
+
+    return ret;
+}
+#endif
+
 void GatewayModuleInterface_dispatch(uint8_t d)
 {
     switch(g_state)
@@ -329,7 +468,30 @@ void GatewayModuleInterface_dispatch(uint8_t d)
                 }
                 else if(g_rx_type == RX_TYPE_RECEIVE)
                 {
-                    g_receive_callback(g_receive_buffer, g_rx_context.length);
+#if DRAIN_SLOTS > 0
+                    if(g_drain.active)
+                    {
+                        // drain mode, the drain function acks the packet and hands over the slots
+                        if(g_drain.fill < DRAIN_SLOTS)
+                        {
+                            memcpy(g_drain_buffer[g_drain.fill], g_receive_buffer, g_rx_context.length);
+                            g_drain_packets[g_drain.fill].data = g_drain_buffer[g_drain.fill];
+                            g_drain_packets[g_drain.fill].size = g_rx_context.length;
+                            g_drain.fill++;
+                            g_drain.received++;
+                            g_signal_set();
+                        }
+                        else
+                        {
+                            // only when the module sends without an ack, not acked so the module keeps the packet
+                            LOG("Drain slots full, packet dropped");
+                        }
+                    }
+                    else
+#endif
+                    {
+                        g_receive_callback(g_receive_buffer, g_rx_context.length);
+                    }
                 }
             }
             else
@@ -347,6 +509,21 @@ static void setState(STATE_t newState)
     g_state = newState;
 }
 
+#if DRAIN_SLOTS > 0
+static void flushDrainBatch(gateway_module_receive_batch_callback_t batch_callback, gateway_module_drain_stats_t* stats)
+{
+    if(g_drain.fill > 0)
+    {
+        if(batch_callback != NULL)
+        {
+            batch_callback(g_drain_packets, g_drain.fill);
+        }
+        stats->batches++;
+        g_drain.fill = 0;
+    }
+}
+#endif
+
 static size_t maxAnswerLength(GATEWAY_MODULE_CMDS_t cmd)
 {
     size_t max_ret_size;
@@ -399,7 +576,7 @@ static size_t maxAnswerLength(GATEWAY_MODULE_CMDS_t cmd)
             break;
 
         case GATEWAY_MODULE_CMD_RECEIVE:
-            max_ret_size = 300;
+            max_ret_size = RECEIVE_BUFFER_SIZE;
             break;
 
         case GATEWAY_MODULE_CMD_RESET:
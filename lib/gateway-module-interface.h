@@ -18,6 +18,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include "gateway-module-interface-config.h"
 
 typedef enum {
     GATEWAY_MODULE_CMD_NONE            = 0,
@@ -52,12 +53,29 @@ typedef enum {
     GATEWAY_MODULE_CMD_MFGDATA = 0x07          // Host -> Module Program Manufact
 } GATEWAY_MODULE_CMDS_t;
 
+typedef struct
+{
+    uint8_t* data;
+    size_t   size;
+} gateway_module_packet_t;
+
+typedef struct
+{
+    size_t   pending;     // Packets reported by the first RXSTATUS
+    size_t   packets;     // Packets pulled from the module RX queue
+    size_t   batches;     // Number of batch callbacks
+    bool     truncated;   // Packet limit reached, remaining packets go to the receive callback
+    uint32_t duration_ms; // Duration of the drain (0 when no time function is given)
+} gateway_module_drain_stats_t;
+
 typedef void (*gateway_module_interface_write_lock_t)(bool lock);
 typedef bool (*gateway_module_interface_write_t)(uint8_t* data, size_t size);
 typedef bool (*gateway_module_signal_wait_t)(int timeout);
 typedef void (*gateway_module_signal_set_t)(void);
 typedef void (*gateway_module_receive_callback_t)(uint8_t* data, size_t size);
 typedef void (*gateway_module_log_t)(const char* format, ...);
+typedef void (*gateway_module_receive_batch_callback_t)(gateway_module_packet_t* packets, size_t count);
+typedef uint32_t (*gateway_module_get_time_t)(void);
 
 void GatewayModuleInterface_init(gateway_module_interface_write_lock_t write_lock,
                                  gateway_module_interface_write_t write, gateway_module_signal_wait_t signal_wait,
@@ -69,6 +87,11 @@ bool GatewayModuleInterface_sendCommandWaitAnswer(GATEWAY_MODULE_CMDS_t cmd, uin
 bool GatewayModuleInterface_sendCommandWaitAck(GATEWAY_MODULE_CMDS_t cmd, uint8_t* cmd_payload,
                                                size_t cmd_payload_size);
 void GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMDS_t cmd, bool ack);
+#if GATEWAY_MODULE_DRAIN_SLOTS > 0
+// stats can be NULL
+bool GatewayModuleInterface_drainReceiveQueue(gateway_module_receive_batch_callback_t batch_callback,
+                                              gateway_module_get_time_t get_time, gateway_module_drain_stats_t* stats);
+#endif
 void GatewayModuleInterface_dispatch(uint8_t d);
 
 #endif /* LIB_GATEWAY_MODULE_INTERFACE_H_ */
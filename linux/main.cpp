@@ -36,6 +36,10 @@ static bool write_uart(uint8_t* data, size_t size);
 static bool signal_wait(int timeout);
 static void signal_set(void);
 static void receive_callback(uint8_t* data, size_t size);
+#if GATEWAY_MODULE_DRAIN_SLOTS > 0
+static void receive_batch_callback(gateway_module_packet_t* packets, size_t count);
+static uint32_t get_time(void);
+#endif
 static void dispatch_thread(void);
 
 void LOG(const char* __restrict __format, ...);
@@ -88,9 +92,23 @@ int main()
         LOG("Failed to ready version");
     }
 
+#if GATEWAY_MODULE_DRAIN_SLOTS > 0
+    // drain the packets queued in the module before startup (if any)
+    LOG("> drain rx queue");
+    gateway_module_drain_stats_t stats;
+    if(!GatewayModuleInterface_drainReceiveQueue(&receive_batch_callback, &get_time, &stats))
+    {
+        LOG("Failed to drain rx queue, packets: %d", stats.packets);
+    }
+    else if(stats.truncated)
+    {
+        LOG("Drain limit reached, packets: %d", stats.packets);
+    }
+#else
     // send receive nack, to trigger current message in rx queue to be replied (if any)
     LOG("> send receive nack, to trigger current message in rx queue to be replied (if any)");
     GatewayModuleInterface_sendAck(GATEWAY_MODULE_CMD_RECEIVE, false);
+#endif
 
     t.join();
 
@@ -163,6 +181,22 @@ static void receive_callback(uint8_t* data, size_t size)
     LOG("TODO: Handle received: %i", size);
 }
 
+#if GATEWAY_MODULE_DRAIN_SLOTS > 0
+static void receive_batch_callback(gateway_module_packet_t* packets, size_t count)
+{
+    size_t i;
+    for(i = 0; i < count; i++)
+    {
+        LOG("TODO: Handle drained: %i", packets[i].size);
+    }
+}
+
+static uint32_t get_time(void)
+{
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
 static void dispatch_thread(void)
 {
     char c;